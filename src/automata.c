@@ -2,12 +2,20 @@
 #include "cellular_grid.h"
 #include "settings.h"
 #include "rendering.h"
+#include "tuning.h"
 
 #include <time.h>
 #include <unistd.h>
+#include <string.h>
+#include <sys/utsname.h>
 #include <mpi.h>
 #include <assert.h>
 #include <math.h>
+#include <limits.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 /***************************** Math and Coordinate functions *****************************/
 
@@ -33,28 +41,38 @@ int position_to_rank(int width, int height, int x, int y){
     return x+y*width;
 }
 
-/***************************** Point generation from Cellular Grid *****************************/
-
-int generate_points_from_CG(cellular_grid CG, cell_point** points, struct comm_schema comm){
-    int nb_points = 0;
-    for (int y=0; y<CG->inner_height; y++) for (int x=0; x<CG->inner_width; x++) if (get_cell(CG,x,y) == 1) nb_points++;
-
-    *points = (cell_point*)malloc(nb_points*sizeof(cell_point));
-    cell_point* list = *points;
-    int index = 0;
-    for (int y=0; y<CG->inner_height; y++)
-        for (int x=0; x<CG->inner_width; x++){
-            if(index==nb_points) break;
-
-            if (get_cell(CG,x,y) == 1){
-                list[index].x = x + comm.x * rounded_division(WIDTH,comm.width);
-                list[index].y = y + comm.y * rounded_division(HEIGHT,comm.height);
-                index++;
-            }
-        }
+/**
+ * @brief Size of the local grid of a process.
+ * 
+ * @param comm The communication schema
+ * @param x Position x of the process in the virtual grid of processes
+ * @param y Position y of the process in the virtual grid of processes
+ * @param local_width The width of the local grid
+ * @param local_height The height of the local grid
+ */
+void local_size(struct comm_schema comm, int x, int y, int* local_width, int* local_height){
+    /* We divide the whole cellular_grid into equal pieces, rounding up to the closest integer (with 0.5 being 0) */
+    *local_width = rounded_division(WIDTH,comm.width);
+    *local_height = rounded_division(HEIGHT,comm.height);
+    /* If it's a border on the right or bottom, we give it the rest of the width of height, to assure that we comply with the grid size we want. */
+    if(x==comm.width-1) *local_width = WIDTH - *local_width * (comm.width - 1);
+    if(y==comm.height-1) *local_height = HEIGHT - *local_height * (comm.height - 1);
+}
 
-    return nb_points;
+/***************************** Point generation from Cellular Grid *****************************/
 
+/**
+ * @brief Creates the buffers receiving the alive cells of our local grid, at their position in the whole grid.
+ * They are filled by the stepper itself (see next_generations), the first generation being extracted here.
+ * 
+ * @param CG Our local Cellular Grid
+ * @param comm The communication schema
+ * @return extraction The extraction buffers
+ */
+extraction create_points_extraction(cellular_grid CG, struct comm_schema comm){
+    extraction E = create_extraction(comm.x * rounded_division(WIDTH,comm.width),comm.y * rounded_division(HEIGHT,comm.height));
+    extract_cells(CG,E);
+    return E;
 }
 
 /***************************** Convolution functions *****************************/
@@ -98,103 +116,244 @@ bit crystallization(bit* neighbors){
 
 /***************************** Communication functions *****************************/
 
+int neighbor_rank(struct comm_schema comm, enum side s){
+    switch (s){
+    case North: return position_to_rank(comm.width,comm.height,comm.x,comm.y-1);
+    case East:  return position_to_rank(comm.width,comm.height,comm.x+1,comm.y);
+    case South: return position_to_rank(comm.width,comm.height,comm.x,comm.y+1);
+    case West:  return position_to_rank(comm.width,comm.height,comm.x-1,comm.y);
+    default:    return -1;
+    }
+}
+
+/***************************** Shared memory functions *****************************/
+
+struct shared_walls{
+    MPI_Comm node_comm;     // Communicator of the processes on our node
+    MPI_Win window;         // Window holding the grid and back buffer of every process of the node
+    bit* own_values;        // Our grid then back buffer, in our part of the window
+    bit* values[4];         // Part of the window of each neighbor (North, East, South, West), NULL if it is on another node
+    int width[4];           // Width of each neighbor's grid (walls included)
+    int height[4];          // Height of each neighbor's grid (walls included)
+};
+
 /**
- * @brief Sends the walls of our local grid to our neighbors, while receiving theirs (might be ourself if one of the dimensions is 1).
- * Uses non-blocking communications without any optimisation.
+ * @brief Allocates the memory of our grid and back buffer in a shared memory window of our node, so neighbors on the same node
+ * can read our walls directly. The grids are then created in it (see own_values), so the memory is never allocated twice.
  * 
- * @param CG Our local Cellular Grid
  * @param comm The communication schema
+ * @param width Width of our grid (walls included)
+ * @param height Height of our grid (walls included)
+ * @return struct shared_walls* The shared memory window and the neighbors found in it
  */
-void transmit_walls(cellular_grid CG, struct comm_schema comm){
-    // Int arrays used to send and receiving the walls
-    int HWall_recv_1[CG->height * 2];
-    int HWall_recv_2[CG->height * 2];    
-    int VWall_recv_1[CG->width * 2];   
-    int VWall_recv_2[CG->width * 2];      
-    int HWall_send_1[CG->height + 2];    
-    int HWall_send_2[CG->height + 2];    
-    int VWall_send_1[CG->width + 2];   
-    int VWall_send_2[CG->width + 2];   
-
-    // Status and Requests used or unused
-    MPI_Status status;
-    MPI_Status * used_status = &status; // MPI_STATUS_IGNORE
-    MPI_Request req_send_1, req_send_2;
-    MPI_Request req_recv_1, req_recv_2;
+struct shared_walls* create_shared_walls(struct comm_schema comm, int width, int height){
+    struct shared_walls* shared = malloc(sizeof(struct shared_walls));
+    MPI_Comm_split_type( MPI_COMM_WORLD , MPI_COMM_TYPE_SHARED , comm.rank , MPI_INFO_NULL , &shared->node_comm);
+
+    // Each process's part is allocated separately, so it stays on the NUMA node that touches it
+    size_t size = (size_t)width*height;
+    bit* segment;
+    MPI_Info info;
+    MPI_Info_create(&info);
+    MPI_Info_set(info,"alloc_shared_noncontig","true");
+    MPI_Win_allocate_shared( (2*size + VALUES_ALIGNMENT - 1)*sizeof(bit) , sizeof(bit) , info , shared->node_comm , &segment , &shared->window);
+    MPI_Info_free(&info);
+    MPI_Win_lock_all( MPI_MODE_NOCHECK , shared->window);
+
+    // The grid and back buffer start at a huge page boundary of our part when using HUGE_PAGES
+    long offset = align_values(segment,2*size);
+    shared->own_values = segment + offset;
+
+    // Dimensions and offset of every grid of the node
+    int node_size;
+    MPI_Comm_size(shared->node_comm,&node_size);
+    long own_dimensions[3] = {width, height, offset};
+    long dimensions[3*node_size];
+    MPI_Allgather( own_dimensions , 3 , MPI_LONG , dimensions , 3 , MPI_LONG , shared->node_comm);
+
+    // Finding which neighbors are on our node
+    MPI_Group world_group, node_group;
+    MPI_Comm_group(MPI_COMM_WORLD,&world_group);
+    MPI_Comm_group(shared->node_comm,&node_group);
+    for(enum side s=North; s<=West; s++){
+        int world_rank = neighbor_rank(comm,s);
+        int node_rank;
+        MPI_Group_translate_ranks( world_group , 1 , &world_rank , node_group , &node_rank);
+
+        shared->values[s] = NULL;
+        if(node_rank==MPI_UNDEFINED) continue;
+
+        MPI_Aint segment_size;
+        int disp_unit;
+        MPI_Win_shared_query( shared->window , node_rank , &segment_size , &disp_unit , &shared->values[s]);
+        shared->values[s] += dimensions[3*node_rank+2];
+        shared->width[s] = dimensions[3*node_rank];
+        shared->height[s] = dimensions[3*node_rank+1];
+    }
+    MPI_Group_free(&world_group);
+    MPI_Group_free(&node_group);
 
-    // Phase 1 : Horizontal Transfer
+    #ifdef V2
+    printf("Process #%d has %d neighbors on its node.\n",comm.rank,(shared->values[North]!=NULL)+(shared->values[East]!=NULL)+(shared->values[South]!=NULL)+(shared->values[West]!=NULL));fflush(stdout);
+    #endif
 
-    // Sub-phase a : send East, receive West
-    get_wall(CG,East,HWall_send_1);
+    return shared;
+}
 
-    MPI_Isend( HWall_send_1 , CG->height , MPI_INT , position_to_rank(comm.width,comm.height,comm.x+1,comm.y) , 0 , MPI_COMM_WORLD , &req_send_1);
-    MPI_Irecv( HWall_recv_2 , CG->height * 2 , MPI_INT , position_to_rank(comm.width,comm.height,comm.x-1,comm.y) , 0 , MPI_COMM_WORLD , &req_recv_2);
+/**
+ * @brief Frees the shared memory window (the Cellular Grid using it must not be used anymore).
+ * 
+ * @param shared The shared memory window
+ */
+void delete_shared_walls(struct shared_walls* shared){
+    MPI_Win_unlock_all(shared->window);
+    MPI_Win_free(&shared->window);
+    MPI_Comm_free(&shared->node_comm);
+    free(shared);
+}
 
-    MPI_Wait( &req_recv_2 , used_status);
-    #ifdef V2
-    printf("Horizontal : Node %d received something from node %d.\n",comm.rank,status.MPI_SOURCE);fflush(stdout);
-    #endif
-    set_wall(CG,West,HWall_recv_2);
+/**
+ * @brief Synchronisation point of the processes of the node, making the writes in the window visible to all of them.
+ * 
+ * @param shared The shared memory window
+ */
+void sync_shared_walls(struct shared_walls* shared){
+    MPI_Win_sync(shared->window);
+    MPI_Barrier(shared->node_comm);
+    MPI_Win_sync(shared->window);
+}
 
-    // Sub-phase b : send West, receive East
-    get_wall(CG,West,HWall_send_2);
+_Bool on_node(struct shared_walls* shared, enum side s){
+    return shared!=NULL && shared->values[s]!=NULL;
+}
 
-    MPI_Isend( HWall_send_2 , CG->height , MPI_INT , position_to_rank(comm.width,comm.height,comm.x-1,comm.y) , 0 , MPI_COMM_WORLD , &req_send_2);
-    MPI_Irecv( HWall_recv_1 , CG->height * 2 , MPI_INT , position_to_rank(comm.width,comm.height,comm.x+1,comm.y) , 0 , MPI_COMM_WORLD , &req_recv_1);
+/**
+ * @brief Current grid of a neighbor on our node. All processes swap their grid and back buffer at the same time,
+ * so the neighbor's current grid is at the same place as ours in its part of the window.
+ * 
+ * @param CG Our local Cellular Grid
+ * @param shared The shared memory window
+ * @param s Side of the neighbor
+ * @return struct _grid The neighbor's grid (not to be deleted)
+ */
+struct _grid shared_neighbor_grid(cellular_grid CG, struct shared_walls* shared, enum side s){
+    size_t size = (size_t)shared->width[s]*shared->height[s];
+    size_t offset = (CG->grid->value==shared->own_values)? 0 : size;
+    struct _grid neighbor = { shared->values[s] + offset, shared->width[s], shared->height[s], size, 0 };
+    return neighbor;
+}
+
+/***************************** Communication functions *****************************/
+
+/**
+ * @brief Sends one of our walls to the neighbor on that side, while receiving the opposite wall from the neighbor on the opposite side.
+ * A neighbor on our node reads our wall by itself, and its wall is read directly from the shared memory window.
+ * 
+ * @param CG Our local Cellular Grid
+ * @param comm The communication schema
+ * @param shared The shared memory window (NULL to only use messages)
+ * @param send_side The wall to send
+ * @param send_buffer Int array used to send the wall
+ * @param recv_buffer Int array used to receive the opposite wall
+ * @param size Size of the walls
+ * @param req_send Request of the send, to wait for later (MPI_REQUEST_NULL if nothing was sent)
+ */
+void exchange_wall(cellular_grid CG, struct comm_schema comm, struct shared_walls* shared, enum side send_side, int* send_buffer, int* recv_buffer, int size, MPI_Request* req_send){
+    enum side recv_side = (send_side+2)%4;
+
+    if(on_node(shared,send_side)){
+        *req_send = MPI_REQUEST_NULL;
+    } else {
+        get_wall(CG,send_side,send_buffer);
+        MPI_Isend( send_buffer , size , MPI_INT , neighbor_rank(comm,send_side) , 0 , MPI_COMM_WORLD , req_send);
+    }
+
+    if(on_node(shared,recv_side)){
+        struct _grid neighbor = shared_neighbor_grid(CG,shared,recv_side);
+        copy_wall(CG,recv_side,&neighbor);
+        return;
+    }
+
+    MPI_Status status;
+    MPI_Request req_recv;
+    MPI_Irecv( recv_buffer , size , MPI_INT , neighbor_rank(comm,recv_side) , 0 , MPI_COMM_WORLD , &req_recv);
 
-    MPI_Wait( &req_recv_1 , used_status);
+    MPI_Wait( &req_recv , &status);
     #ifdef V2
-    printf("Horizontal : Node %d received something from node %d.\n",comm.rank,status.MPI_SOURCE);fflush(stdout);
+    printf("%s : Node %d received something from node %d.\n",(recv_side==East || recv_side==West)?"Horizontal":"Vertical",comm.rank,status.MPI_SOURCE);fflush(stdout);
     #endif
-    set_wall(CG,East,HWall_recv_1);
+    set_wall(CG,recv_side,recv_buffer);
+}
 
-    // We wait for sends just in case
-    MPI_Wait( &req_send_1, NULL);
-    MPI_Wait( &req_send_2, NULL);
+/**
+ * @brief Sends the walls of our local grid to our neighbors, while receiving theirs (might be ourself if one of the dimensions is 1).
+ * Uses non-blocking communications, except for neighbors on our node when a shared memory window is given.
+ * 
+ * @param CG Our local Cellular Grid
+ * @param comm The communication schema
+ * @param shared The shared memory window (NULL to only use messages)
+ */
+void transmit_walls(cellular_grid CG, struct comm_schema comm, struct shared_walls* shared){
+    // Int arrays used to send and receiving the walls (one line per layer of the halo), only needed if a neighbor is on another node.
+    // They are kept in the Cellular Grid, and the phases are done one after the other so both use the same arrays.
+    int HWall_size = CG->height * CG->halo;
+    int VWall_size = CG->width * CG->halo;
+    int wall_size = (HWall_size>VWall_size)? HWall_size : VWall_size;
+    int *Wall_send_1 = NULL, *Wall_send_2 = NULL, *Wall_recv_1 = NULL, *Wall_recv_2 = NULL;
+    if(!(on_node(shared,North) && on_node(shared,East) && on_node(shared,South) && on_node(shared,West))){
+        if(CG->walls==NULL) CG->walls = malloc(4*(size_t)wall_size*sizeof(int));
+        Wall_send_1 = CG->walls;
+        Wall_send_2 = CG->walls + wall_size;
+        Wall_recv_1 = CG->walls + 2*(size_t)wall_size;
+        Wall_recv_2 = CG->walls + 3*(size_t)wall_size;
+    }
 
+    MPI_Request req_send_1, req_send_2;
 
-    // Phase 2 : Vertical Transfer
+    // Neighbors on our node must be done with their last generation before we read their walls
+    if(shared) sync_shared_walls(shared);
 
-    // Sub-phase a : send South, receive North
-    get_wall(CG,South,VWall_send_1);
+    // Phase 1 : Horizontal Transfer
 
-    MPI_Isend( VWall_send_1 , CG->width , MPI_INT , position_to_rank(comm.width,comm.height,comm.x,comm.y+1) , 0 , MPI_COMM_WORLD , &req_send_1);
-    MPI_Irecv( VWall_recv_2 , CG->width * 2 , MPI_INT , position_to_rank(comm.width,comm.height,comm.x,comm.y-1) , 0 , MPI_COMM_WORLD , &req_recv_2);
+    // Sub-phase a : send East, receive West
+    exchange_wall(CG,comm,shared,East,Wall_send_1,Wall_recv_2,HWall_size,&req_send_1);
 
-    MPI_Wait( &req_recv_2 , used_status);
-    #ifdef V2
-    printf("Vertical : Node %d received something from node %d.\n",comm.rank,status.MPI_SOURCE);fflush(stdout);
-    #endif
-    set_wall(CG,North,VWall_recv_2);
+    // Sub-phase b : send West, receive East
+    exchange_wall(CG,comm,shared,West,Wall_send_2,Wall_recv_1,HWall_size,&req_send_2);
 
-    // Sub-phase b : send North, receive South
-    get_wall(CG,North,VWall_send_2);
+    // We wait for sends just in case
+    MPI_Wait( &req_send_1, MPI_STATUS_IGNORE);
+    MPI_Wait( &req_send_2, MPI_STATUS_IGNORE);
 
-    MPI_Isend( VWall_send_2 , CG->width , MPI_INT , position_to_rank(comm.width,comm.height,comm.x,comm.y-1) , 0 , MPI_COMM_WORLD , &req_send_2);
-    MPI_Irecv( VWall_recv_1 , CG->width * 2 , MPI_INT , position_to_rank(comm.width,comm.height,comm.x,comm.y+1) , 0 , MPI_COMM_WORLD , &req_recv_1);
+    // Neighbors on our node must have received their horizontal walls (our corners) before we read their vertical ones
+    if(shared) sync_shared_walls(shared);
 
-    MPI_Wait( &req_recv_1 , used_status);
-    #ifdef V2
-    printf("Vertical : Node %d received something from node %d.\n",comm.rank,status.MPI_SOURCE);fflush(stdout);
-    #endif
-    set_wall(CG,South,VWall_recv_1);
+    // Phase 2 : Vertical Transfer
 
+    // Sub-phase a : send South, receive North
+    exchange_wall(CG,comm,shared,South,Wall_send_1,Wall_recv_2,VWall_size,&req_send_1);
 
-    MPI_Wait( &req_send_1, NULL);
-    MPI_Wait( &req_send_2, NULL);
+    // Sub-phase b : send North, receive South
+    exchange_wall(CG,comm,shared,North,Wall_send_2,Wall_recv_1,VWall_size,&req_send_2);
+
+    MPI_Wait( &req_send_1, MPI_STATUS_IGNORE);
+    MPI_Wait( &req_send_2, MPI_STATUS_IGNORE);
 }
 
 /**
  * @brief Gather all the data to 1 node for rendering
  * 
- * @param CG Our local Cellular Grid
+ * @param E The alive cells of our local grid, extracted by the stepper
  * @param comm The communication schema
  * @param master The rank of the node choosen to gather everything
  */
-void gather_to_one(cellular_grid CG, struct comm_schema comm, int generation, MPI_Datatype mpi_point){
-    // Retrieving points to send
-    cell_point ** points = malloc(sizeof(cell_point*));
-    int nb_points = generate_points_from_CG(CG,points,comm);
+void gather_to_one(extraction E, struct comm_schema comm, int generation, MPI_Datatype mpi_point){
+    // Retrieving points to send (MPI counts are int : beyond that, the viewport gather must be used)
+    if(E->nb_points>INT_MAX){
+        fprintf(stderr,"Process #%d has %zu points, too many to gather (at most %d) : use VIEWPORT.\n",comm.rank,E->nb_points,INT_MAX);
+        MPI_Abort(MPI_COMM_WORLD,1);
+    }
+    int nb_points = (int)E->nb_points;
     #ifdef V2
     printf("Process #%d has %d points.\n",comm.rank,nb_points);fflush(stdout);
     #endif
@@ -203,12 +362,16 @@ void gather_to_one(cellular_grid CG, struct comm_schema comm, int generation, MP
     int *incoming_sizes = malloc(sizeof(int)*comm.size);
     MPI_Gather( &nb_points , 1 , MPI_INT , incoming_sizes , 1 , MPI_INT , comm.master , MPI_COMM_WORLD);
 
-    int total_points = 0;
+    long total_points = 0;
     for(int i=0; comm.rank==comm.master && i<comm.size; i++)  total_points += incoming_sizes[i];
+    if(total_points>INT_MAX){
+        fprintf(stderr,"%ld points, too many to gather (at most %d) : use VIEWPORT.\n",total_points,INT_MAX);
+        MPI_Abort(MPI_COMM_WORLD,1);
+    }
 
     #ifdef V2
     if(comm.rank==comm.master) {
-        printf("Process #0 has gathered %d points.\n",total_points);fflush(stdout);
+        printf("Process #0 has gathered %ld points.\n",total_points);fflush(stdout);
         for(int i=0; i<comm.size; i++){
             printf("Gathered %d is %d.\n",i,incoming_sizes[i]);fflush(stdout);
         }
@@ -227,7 +390,7 @@ void gather_to_one(cellular_grid CG, struct comm_schema comm, int generation, MP
         }
     }
 
-    MPI_Gatherv( *points , nb_points , mpi_point , gather_buff , incoming_sizes , displacements , mpi_point , comm.master , MPI_COMM_WORLD);
+    MPI_Gatherv( E->points , nb_points , mpi_point , gather_buff , incoming_sizes , displacements , mpi_point , comm.master , MPI_COMM_WORLD);
 
     // Rendering generation
     if(comm.rank==comm.master){
@@ -235,59 +398,523 @@ void gather_to_one(cellular_grid CG, struct comm_schema comm, int generation, MP
         free(gather_buff);
     }
     free(incoming_sizes);
-    free(*points);
-    free(points);
 
     MPI_Barrier( MPI_COMM_WORLD);
 }
 
-/***************************** Main loop function *****************************/
+/**
+ * @brief Keeps the viewport inside the grid, with a zoom of at least 1.
+ * 
+ * @param view The viewport to clip
+ */
+void clip_viewport(struct viewport* view){
+    if(view->zoom<1) view->zoom = 1;
+    if(view->x<0) { view->width += view->x; view->x = 0; }
+    if(view->y<0) { view->height += view->y; view->y = 0; }
+    if(view->x>WIDTH) view->x = WIDTH;
+    if(view->y>HEIGHT) view->y = HEIGHT;
+    if(view->width>WIDTH-view->x) view->width = WIDTH-view->x;
+    if(view->height>HEIGHT-view->y) view->height = HEIGHT-view->y;
+    if(view->width<0) view->width = 0;
+    if(view->height<0) view->height = 0;
+}
 
-int automata_loop(int argc, char** argv){
-    // MPI Initialization 
-    MPI_Init(&argc,&argv);
-    struct comm_schema comm;
+/**
+ * @brief Part of the viewport held by a process : the cells of its local grid inside the viewport, and the pixels showing them.
+ * 
+ * @param comm The communication schema
+ * @param x Position x of the process in the virtual grid of processes
+ * @param y Position y of the process in the virtual grid of processes
+ * @param view The viewport (clipped)
+ * @param cells Receives the rectangle of cells in the whole grid (x start, y start, x end, y end, ends excluded)
+ * @param pixels Receives the rectangle of pixels in the frame (same format)
+ * @return int Number of pixels of the part (0 if the process holds nothing of the viewport)
+ */
+int viewport_part(struct comm_schema comm, int x, int y, struct viewport view, int cells[4], int pixels[4]){
+    int local_width, local_height;
+    local_size(comm,x,y,&local_width,&local_height);
+    int offset_x = x * rounded_division(WIDTH,comm.width);
+    int offset_y = y * rounded_division(HEIGHT,comm.height);
+
+    cells[0] = (offset_x > view.x)? offset_x : view.x;
+    cells[1] = (offset_y > view.y)? offset_y : view.y;
+    cells[2] = (offset_x+local_width < view.x+view.width)? offset_x+local_width : view.x+view.width;
+    cells[3] = (offset_y+local_height < view.y+view.height)? offset_y+local_height : view.y+view.height;
+    if(cells[0]>=cells[2] || cells[1]>=cells[3]){
+        for(int i=0; i<4; i++) pixels[i] = 0;
+        return 0;
+    }
 
-    MPI_Comm_size(MPI_COMM_WORLD,&comm.size);
-    MPI_Comm_rank(MPI_COMM_WORLD,&comm.rank);
+    pixels[0] = (cells[0]-view.x)/view.zoom;
+    pixels[1] = (cells[1]-view.y)/view.zoom;
+    pixels[2] = (cells[2]-1-view.x)/view.zoom + 1;
+    pixels[3] = (cells[3]-1-view.y)/view.zoom + 1;
+    return (pixels[2]-pixels[0])*(pixels[3]-pixels[1]);
+}
 
-    // Communication schema creation (virtual grid of automata cells)
-    comm.height = find_factor(comm.size);
-    comm.width = comm.size/comm.height;
+/**
+ * @brief Gather a downsampled viewport of the grid to 1 node for rendering. Each pixel holds the number of alive cells
+ * of the zoom*zoom square of cells it shows. Each process only sends the pixels showing its own cells, and the pixels
+ * shared by several processes are summed by the master, so only the size of the screen goes through the network.
+ * 
+ * @param CG Our local Cellular Grid
+ * @param comm The communication schema
+ * @param generation The generation rendered
+ * @param view The viewport requested by the master (shared with the others at each generation, so it can change)
+ */
+void gather_viewport(cellular_grid CG, struct comm_schema comm, int generation, struct viewport* view){
+    if(comm.rank==comm.master) clip_viewport(view);
+    MPI_Bcast( view , 5 , MPI_INT , comm.master , MPI_COMM_WORLD);
+    if(view->width==0 || view->height==0) return;
+
+    // Downsampling the pixels showing our cells
+    int cells[4], pixels[4];
+    int nb_pixels = viewport_part(comm,comm.x,comm.y,*view,cells,pixels);
+    int part_width = pixels[2]-pixels[0];
+    int *part = malloc(nb_pixels*sizeof(int));
+    int offset_x = comm.x * rounded_division(WIDTH,comm.width);
+    int offset_y = comm.y * rounded_division(HEIGHT,comm.height);
+    for(int py=pixels[1]; py<pixels[3]; py++){
+        for(int px=pixels[0]; px<pixels[2]; px++){
+            int cell_x = view->x + px*view->zoom;
+            int cell_y = view->y + py*view->zoom;
+            int x_start = (cell_x > cells[0])? cell_x : cells[0];
+            int y_start = (cell_y > cells[1])? cell_y : cells[1];
+            int x_end = (cell_x+view->zoom < cells[2])? cell_x+view->zoom : cells[2];
+            int y_end = (cell_y+view->zoom < cells[3])? cell_y+view->zoom : cells[3];
+            part[(py-pixels[1])*part_width + px-pixels[0]] = count_cells(CG,x_start-offset_x,y_start-offset_y,x_end-x_start,y_end-y_start);
+        }
+    }
 
-    comm.y = comm.rank/comm.width;
-    comm.x = comm.rank%comm.width;
+    // The master knows the part of every process, so only the pixels are gathered
+    int *incoming_sizes = NULL;
+    int *displacements = NULL;
+    int *incoming_pixels = NULL;
+    int total_pixels = 0;
+    if(comm.rank==comm.master){
+        incoming_sizes = malloc(comm.size*sizeof(int));
+        displacements = malloc(comm.size*sizeof(int));
+        incoming_pixels = malloc(4*comm.size*sizeof(int));
+        for(int r=0; r<comm.size; r++){
+            incoming_sizes[r] = viewport_part(comm,r%comm.width,r/comm.width,*view,cells,incoming_pixels+4*r);
+            displacements[r] = total_pixels;
+            total_pixels += incoming_sizes[r];
+        }
+    }
+    int *parts = (comm.rank==comm.master)? malloc(total_pixels*sizeof(int)) : NULL;
+    MPI_Gatherv( part , nb_pixels , MPI_INT , parts , incoming_sizes , displacements , MPI_INT , comm.master , MPI_COMM_WORLD);
 
-    comm.master = 0; 
+    // Rendering generation, after summing the parts in the frame
+    if(comm.rank==comm.master){
+        int frame_width = (view->width + view->zoom - 1)/view->zoom;
+        int frame_height = (view->height + view->zoom - 1)/view->zoom;
+        int *frame = calloc(frame_width*frame_height,sizeof(int));
+        for(int r=0; r<comm.size; r++){
+            int* p = incoming_pixels+4*r;
+            for(int py=p[1]; py<p[3]; py++)
+                for(int px=p[0]; px<p[2]; px++)
+                    frame[py*frame_width + px] += parts[displacements[r] + (py-p[1])*(p[2]-p[0]) + px-p[0]];
+        }
+        render_frame(frame,*view,generation);
+        free(frame);
+        free(parts);
+        free(incoming_sizes);
+        free(displacements);
+        free(incoming_pixels);
+    }
+    free(part);
 
-    // Automata grid creation
+    MPI_Barrier( MPI_COMM_WORLD);
+}
 
-    /* We divide the whole cellular_grid into equal pieces, rounding up to the closest integer (with 0.5 being 0) */
-    int local_width = rounded_division(WIDTH,comm.width);
-    int local_height = rounded_division(HEIGHT,comm.height);
-    /* If it's a border on the right or bottom, we give it the rest of the width of height, to assure that we comply with the grid size we want. */
-    if(comm.x==comm.width-1) local_width = WIDTH - local_width * (comm.width - 1);
-    if(comm.y==comm.height-1) local_height = HEIGHT - local_height * (comm.height - 1);
+/***************************** Configuration functions *****************************/
+
+/**
+ * @brief Sets the virtual grid of processes of the communication schema.
+ * 
+ * @param comm The communication schema (size and rank already set)
+ * @param comm_height Number of rows of processes (must divide the number of processes)
+ */
+void create_comm_schema(struct comm_schema* comm, int comm_height){
+    comm->height = comm_height;
+    comm->width = comm->size/comm->height;
+
+    comm->y = comm->rank/comm->width;
+    comm->x = comm->rank%comm->width;
+}
+
+/**
+ * @brief Creates our local grid, filled at random with one alive cell out of INITIAL_DENSITY.
+ * With SHARED_MEMORY, it is created directly in a shared memory window of our node.
+ * 
+ * @param comm The communication schema
+ * @param local_width Width of our local grid (the same for every process of a column)
+ * @param local_height Height of our local grid (the same for every process of a row)
+ * @param halo Depth of the walls
+ * @param rule The convolution function
+ * @param shared Receives the shared memory window (NULL without SHARED_MEMORY)
+ * @return cellular_grid Our local Cellular Grid
+ */
+cellular_grid create_local_grid(struct comm_schema comm, int local_width, int local_height, int halo, bit (* rule) (bit *), struct shared_walls** shared){
+    /* The halo can't be deeper than the smallest node, since walls are only exchanged with direct neighbors */
+    int smallest_side = (local_width<local_height)?local_width:local_height;
+    MPI_Allreduce( MPI_IN_PLACE , &smallest_side , 1 , MPI_INT , MPI_MIN , MPI_COMM_WORLD);
+    assert(halo>0 && halo<=smallest_side);
+
+    #ifdef SHARED_MEMORY
+    size_t size = (size_t)(local_width+2*halo)*(local_height+2*halo);
+    *shared = create_shared_walls(comm,local_width+2*halo,local_height+2*halo);
+    cellular_grid CG = create_cell_grid_from(local_width,local_height,halo,rule,(*shared)->own_values,(*shared)->own_values + size);
+    #else
+    *shared = NULL;
+    cellular_grid CG = create_cell_grid(local_width,local_height,halo,rule);
+    #endif
+
+    for(long i=0; i<(long)local_width*local_height/INITIAL_DENSITY; i++){
+        set_cell(CG,rand()%local_width,rand()%local_height,1);
+    }
+    return CG;
+}
+
+/**
+ * @brief Computes the next generations of our local grid with the stepper of the configuration.
+ * 
+ * @param CG Our local Cellular Grid
+ * @param t The configuration
+ * @param steps Number of generations to compute (at most the halo)
+ * @param E The extraction buffers filled with the last generation (NULL for no extraction)
+ */
+void step_local_grid(cellular_grid CG, struct tuning t, int steps, extraction E){
+    if(t.kernel==0){
+        // The reference stepper can't extract while stepping
+        next_generation(CG);
+        if(E!=NULL) extract_cells(CG,E);
+    } else {
+        next_generations(CG,steps,t.tile_width,t.tile_height,E);
+    }
+}
+
+struct tuning default_tuning(struct comm_schema comm){
+    struct tuning t;
+    t.kernel = 1;
+    t.tile_width = TILE_WIDTH;
+    t.tile_height = TILE_HEIGHT;
+    t.halo = HALO_DEPTH;
+    #ifdef _OPENMP
+    t.threads = omp_get_max_threads();
+    #else
+    t.threads = 1;
+    #endif
+    t.comm_height = find_factor(comm.size);
+    return t;
+}
+
+/***************************** Auto-tuning functions *****************************/
+
+char* rule_name(bit (* rule) (bit *)){
+    if(rule==conway) return "conway";
+    if(rule==conway_modified) return "conway_modified";
+    if(rule==crystallization) return "crystallization";
+    return "unknown";
+}
+
+/**
+ * @brief Signature of the problem, used as key in the tuning file : grid size, rule, density, number of processes, rendering,
+ * build options changing the fastest configuration (shared memory, huge pages, OpenMP) and machine.
+ * 
+ * @param signature String receiving the signature
+ * @param length Length of the string
+ * @param comm The communication schema
+ * @param rule The convolution function
+ */
+void tuning_signature(char* signature, int length, struct comm_schema comm, bit (* rule) (bit *)){
+    struct utsname machine;
+    uname(&machine);
+    #ifdef NORENDER
+    char* render = "norender";
+    #else
+    char* render = "render";
+    #endif
+    #ifdef SHARED_MEMORY
+    char* transport = "sharedmemory";
+    #else
+    char* transport = "messages";
+    #endif
+    #ifdef HUGE_PAGES
+    char* pages = "hugepages";
+    #else
+    char* pages = "pages";
+    #endif
+    #ifdef _OPENMP
+    char* openmp = "openmp";
+    #else
+    char* openmp = "noopenmp";
+    #endif
+    snprintf(signature,length,"%dx%d_%s_density%d_np%d_%s_%s_%s_%s_%s_%ldcpus_%dthreads",WIDTH,HEIGHT,rule_name(rule),INITIAL_DENSITY,comm.size,render,transport,pages,openmp,machine.machine,sysconf(_SC_NPROCESSORS_ONLN),default_tuning(comm).threads);
+}
+
+_Bool valid_tuning(struct comm_schema comm, struct tuning t){
+    if(t.comm_height<1 || comm.size%t.comm_height!=0) return 0;
+    if(t.halo<1 || t.tile_width<1 || t.tile_height<1 || t.threads<1) return 0;
+    // The reference stepper only computes one generation per exchange
+    if(t.kernel==0 && t.halo!=1) return 0;
+    #ifndef NORENDER
+    // The rendering expects HALO_DEPTH generations in-between each rendered generation
+    if(t.halo!=HALO_DEPTH) return 0;
+    #endif
+
+    // The halo can't be deeper than the smallest node (the last column and row of processes get the rest of the grid)
+    int local_width, local_height;
+    create_comm_schema(&comm,t.comm_height);
+    local_size(comm,comm.width-1,comm.height-1,&local_width,&local_height);
+    int smallest_width = (local_width<rounded_division(WIDTH,comm.width))? local_width : rounded_division(WIDTH,comm.width);
+    int smallest_height = (local_height<rounded_division(HEIGHT,comm.height))? local_height : rounded_division(HEIGHT,comm.height);
+    return t.halo<=smallest_width && t.halo<=smallest_height;
+}
+
+/**
+ * @brief Scale of the sample grids benchmarked by the auto-tuning. A process's sample holds enough cells for its grid
+ * and back buffer to fill TUNING_SAMPLE_CACHES times its cache (its L2, or its share of the last level cache if bigger),
+ * so the tiles and the halo are timed out of cache like on the real grid. The scale is the same for every process and
+ * every decomposition, so they all benchmark about the same number of cells, with the shape of their real local grid.
+ * 
+ * @param comm The communication schema
+ * @return double Factor applied to both sides of the local grids (1 when the real grids are small enough)
+ */
+double tuning_sample_scale(struct comm_schema comm){
+    long cache = 0, last_level = 0;
+    #ifdef _SC_LEVEL2_CACHE_SIZE
+    cache = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    #endif
+    #ifdef _SC_LEVEL3_CACHE_SIZE
+    last_level = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    #endif
+    if(cache<=0) cache = 1<<21;
+
+    // The last level cache is shared by the cores of the node
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if(last_level>0 && cpus>0 && last_level/cpus*default_tuning(comm).threads>cache) cache = last_level/cpus*default_tuning(comm).threads;
+
+    long sample_cells = TUNING_SAMPLE_CACHES*cache/(2*sizeof(bit));
+    MPI_Allreduce( MPI_IN_PLACE , &sample_cells , 1 , MPI_LONG , MPI_MIN , MPI_COMM_WORLD);
+    double scale = sqrt((double)sample_cells*comm.size/((double)WIDTH*HEIGHT));
+    return (scale<1)? scale : 1;
+}
+
+/**
+ * @brief Times a few generations (TUNING_GENERATIONS) computed with a configuration, on a sample grid created for it :
+ * both sides of each local grid are scaled down by the same factor, so the tuning time doesn't grow with the grid.
+ * After a warm-up exchange and step, the generations are timed TUNING_REPEATS times and the fastest run is kept.
+ * The time is divided by the number of cells and generations benchmarked, to compare decompositions whose samples differ by rounding.
+ * 
+ * What a scaled down sample can't tell apart : its walls shrink with the scale but its area with the scale squared, so
+ * exchanges weigh more than in the real run (favouring decompositions with short walls and deep halos), and tiles at least
+ * as large as the sample are all clamped to the whole sample (a {WIDTH,16} tile still means full rows).
+ * 
+ * @param comm The communication schema
+ * @param t The configuration
+ * @param rule The convolution function
+ * @param scale Scale of the sample grids (see tuning_sample_scale)
+ * @return double Time per cell and generation of the slowest process, in the fastest run
+ */
+double benchmark_tuning(struct comm_schema comm, struct tuning t, bit (* rule) (bit *), double scale){
+    #ifdef _OPENMP
+    omp_set_num_threads(t.threads);
+    #endif
+    create_comm_schema(&comm,t.comm_height);
+    int local_width, local_height;
+    local_size(comm,comm.x,comm.y,&local_width,&local_height);
+
+    // Sides only depend on the column or row of the process, so neighbors' walls still match
+    int sample_width = (int)ceil(local_width*scale);
+    int sample_height = (int)ceil(local_height*scale);
+    int min_width = (local_width<t.halo)? local_width : t.halo;
+    int min_height = (local_height<t.halo)? local_height : t.halo;
+    if(sample_width<min_width) sample_width = min_width;
+    if(sample_height<min_height) sample_height = min_height;
+    if(sample_width>local_width) sample_width = local_width;
+    if(sample_height>local_height) sample_height = local_height;
+    double cells = (double)sample_width*sample_height;
+    MPI_Allreduce( MPI_IN_PLACE , &cells , 1 , MPI_DOUBLE , MPI_SUM , MPI_COMM_WORLD);
+
+    struct shared_walls* shared;
+    cellular_grid CG = create_local_grid(comm,sample_width,sample_height,t.halo,rule,&shared);
+
+    // Warm-up (first touch of the walls buffers, caches, threads)
+    transmit_walls(CG,comm,shared);
+    step_local_grid(CG,t,t.halo,NULL);
+
+    double best = INFINITY;
+    for(int r=0; r<TUNING_REPEATS; r++){
+        MPI_Barrier(MPI_COMM_WORLD);
+        double start = MPI_Wtime();
+        for(int i=0; i<TUNING_GENERATIONS; i+=t.halo){
+            int steps = (i+t.halo>TUNING_GENERATIONS)? TUNING_GENERATIONS-i : t.halo;
+            transmit_walls(CG,comm,shared);
+            step_local_grid(CG,t,steps,NULL);
+        }
+        double elapsed = MPI_Wtime() - start;
+        MPI_Allreduce( MPI_IN_PLACE , &elapsed , 1 , MPI_DOUBLE , MPI_MAX , MPI_COMM_WORLD);
+        if(elapsed<best) best = elapsed;
+    }
+
+    delete_cell_grid(CG);
+    if(shared) delete_shared_walls(shared);
+    return best/(cells*TUNING_GENERATIONS);
+}
 
-    cellular_grid CG = create_cell_grid(local_width,local_height,conway);
+/**
+ * @brief Benchmarks a candidate configuration, and keeps it if it is faster than the best one so far by more than
+ * TUNING_MARGIN, so that a configuration winning by noise doesn't replace the best one (nor gets saved).
+ * As every process gets the same times, they all make the same choices.
+ */
+void try_tuning(struct comm_schema comm, struct tuning t, bit (* rule) (bit *), double scale, struct tuning* best, double* best_time){
+    if(!valid_tuning(comm,t) || memcmp(&t,best,sizeof(struct tuning))==0) return;
 
+    double time = benchmark_tuning(comm,t,rule,scale);
     #ifdef V1
     if(comm.rank==comm.master){
-        printf("\nComm : %d x %d\nNode : %d x %d\n",comm.width,comm.height,local_width,local_height); fflush(stdout);
+        printf("Tuning : kernel %d, tiles %dx%d, halo %d, %d threads, %d rows of processes : %.3lfns per cell and generation.\n",t.kernel,t.tile_width,t.tile_height,t.halo,t.threads,t.comm_height,time*1e9); fflush(stdout);
     }
     #endif
+    if(time<*best_time*(1-TUNING_MARGIN)){
+        *best = t;
+        *best_time = time;
+    }
+}
+
+/**
+ * @brief Searches the fastest configuration of the tiled stepper, one parameter at a time (decomposition, tiles, halo,
+ * then threads), starting from the given one. The reference stepper is left out, as it is never faster.
+ * 
+ * @param comm The communication schema
+ * @param start The configuration to start from
+ * @param rule The convolution function
+ * @return struct tuning The fastest configuration found
+ */
+struct tuning autotune(struct comm_schema comm, struct tuning start, bit (* rule) (bit *)){
+    double scale = tuning_sample_scale(comm);
+    #ifdef V1
+    if(comm.rank==comm.master){
+        printf("Tuning on sample grids scaled by %lf.\n",scale); fflush(stdout);
+    }
+    #endif
+    struct tuning best = start;
+    double best_time = valid_tuning(comm,best)? benchmark_tuning(comm,best,rule,scale) : INFINITY;
+    struct tuning t;
+
+    // Decomposition
+    for(int rows=1; rows<=comm.size; rows++){
+        t = best;
+        t.comm_height = rows;
+        try_tuning(comm,t,rule,scale,&best,&best_time);
+    }
+
+    // Tiles
+    int tiles[][2] = {{64,32},{128,64},{256,128},{512,256},{WIDTH,16}};
+    for(int i=0; i<5; i++){
+        t = best;
+        t.tile_width = tiles[i][0];
+        t.tile_height = tiles[i][1];
+        try_tuning(comm,t,rule,scale,&best,&best_time);
+    }
+
+    // Halo
+    for(int halo=1; halo<=8; halo*=2){
+        t = best;
+        t.halo = halo;
+        try_tuning(comm,t,rule,scale,&best,&best_time);
+    }
+
+    // Threads
+    for(int threads=start.threads; threads>=1; threads/=2){
+        t = best;
+        t.threads = threads;
+        try_tuning(comm,t,rule,scale,&best,&best_time);
+    }
+
+    assert(best_time<INFINITY);
+    return best;
+}
+
+/**
+ * @brief Configuration of the computation : the one saved in the tuning file for this problem if there is one,
+ * otherwise the fastest one found by autotune, which is then saved.
+ * 
+ * @param comm The communication schema
+ * @param rule The convolution function
+ * @return struct tuning The configuration to use
+ */
+struct tuning tuned_configuration(struct comm_schema comm, bit (* rule) (bit *)){
+    struct tuning t = default_tuning(comm);
+    char signature[256];
+    tuning_signature(signature,sizeof(signature),comm,rule);
+
+    int found = 0;
+    if(comm.rank==comm.master) found = read_tuning(TUNING_FILE,signature,&t);
+    MPI_Bcast( &found , 1 , MPI_INT , comm.master , MPI_COMM_WORLD);
+
+    if(found){
+        MPI_Bcast( &t , sizeof(struct tuning)/sizeof(int) , MPI_INT , comm.master , MPI_COMM_WORLD);
+        if(valid_tuning(comm,t)) return t;
+    }
+
+    t = autotune(comm,t,rule);
+    if(comm.rank==comm.master) write_tuning(TUNING_FILE,signature,t);
+    return t;
+}
+
+/***************************** Main loop function *****************************/
+
+int automata_loop(int argc, char** argv){
+    // MPI Initialization 
+    int thread_support; // Only the main thread communicates, the others only step the grid
+    MPI_Init_thread(&argc,&argv,MPI_THREAD_FUNNELED,&thread_support);
+    struct comm_schema comm;
+
+    MPI_Comm_size(MPI_COMM_WORLD,&comm.size);
+    MPI_Comm_rank(MPI_COMM_WORLD,&comm.rank);
+
+    comm.master = 0; 
 
-    // Automata grid values initialization at random
     time_t t;
     srand((unsigned) time(&t) + comm.rank);
 
-    for(int i=0; i<local_width*local_height/10; i++){
-        set_cell(CG,rand()%local_width,rand()%local_height,1);
+    // Configuration of the computation (see tuning.h/.c)
+    #ifdef AUTOTUNE
+    struct tuning config = tuned_configuration(comm,conway);
+    #else
+    struct tuning config = default_tuning(comm);
+    #endif
+    #ifdef _OPENMP
+    omp_set_num_threads(config.threads);
+    #endif
+    int halo = config.halo;
+
+    // Communication schema creation (virtual grid of automata cells)
+    create_comm_schema(&comm,config.comm_height);
+
+    // Automata grid creation (in shared memory with SHARED_MEMORY), with values initialized at random
+    int local_width, local_height;
+    local_size(comm,comm.x,comm.y,&local_width,&local_height);
+    struct shared_walls* shared;
+    cellular_grid CG = create_local_grid(comm,local_width,local_height,halo,conway,&shared);
+
+    #ifdef V1
+    if(comm.rank==comm.master){
+        printf("\nComm : %d x %d\nNode : %d x %d\nHalo : %d\nKernel : %d (tiles %d x %d, %d threads)\n",comm.width,comm.height,CG->inner_width,CG->inner_height,halo,config.kernel,config.tile_width,config.tile_height,config.threads); fflush(stdout);
     }
+    #endif
 
     // Creating rendering (see rendering.h/.c)
     if(comm.rank == comm.master){
+        #if VIEWPORT
+        struct viewport first_view = { VIEWPORT_X, VIEWPORT_Y, VIEWPORT_WIDTH, VIEWPORT_HEIGHT, VIEWPORT_ZOOM };
+        clip_viewport(&first_view);
+        create_render(OUTPUT_PATH,(first_view.width+first_view.zoom-1)/first_view.zoom,(first_view.height+first_view.zoom-1)/first_view.zoom);
+        #else
         create_render(OUTPUT_PATH,WIDTH,HEIGHT);
+        #endif
     }
 
     // Creating MPI structure later used for gathering
@@ -317,6 +944,14 @@ int automata_loop(int argc, char** argv){
 
 
 
+    // Viewport requested by the master when gathering a downsampled grid, or alive cells extracted by the stepper otherwise
+    #if VIEWPORT
+    struct viewport view = { VIEWPORT_X, VIEWPORT_Y, VIEWPORT_WIDTH, VIEWPORT_HEIGHT, VIEWPORT_ZOOM };
+    extraction points = NULL;
+    #else
+    extraction points = create_points_extraction(CG,comm);
+    #endif
+
     // Main loop
 
     #ifdef V1
@@ -324,16 +959,21 @@ int automata_loop(int argc, char** argv){
     if(comm.rank==comm.master)
         printf("Main loop is starting.\n");
     #endif
-    for(int i=0; i<ITERATIONS; i++){
+    for(int i=0; i<ITERATIONS; i+=halo){
         #ifdef V1
         if(comm.rank==comm.master) start = clock();
         #endif
-        // Gather generations points to one process so it can be saved in svg
-        gather_to_one(CG,comm,i,cell_point_type); 
+        // Gather generations points (or the viewport) to one process so it can be saved in svg
+        #if VIEWPORT
+        gather_viewport(CG,comm,i,&view);
+        #else
+        gather_to_one(points,comm,i,cell_point_type); 
+        #endif
 
-        // Next Generation computation
-        transmit_walls(CG,comm);
-        next_generation(CG);
+        // Next Generations computation, as many as the halo allows between two exchanges
+        int steps = (i+halo>ITERATIONS)? ITERATIONS-i : halo;
+        transmit_walls(CG,comm,shared);
+        step_local_grid(CG,config,steps,points);
         MPI_Barrier(MPI_COMM_WORLD);
 
         #ifdef V1
@@ -346,6 +986,10 @@ int automata_loop(int argc, char** argv){
 
     if(comm.rank==comm.master) finish_render();
 
+    if(points) delete_extraction(points);
+    delete_cell_grid(CG);
+    if(shared) delete_shared_walls(shared);
+
     MPI_Finalize();
     return 0;
 }
\ No newline at end of file
@@ -1,9 +1,15 @@
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 #include "cellular_grid.h"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 
 _Bool valid_coordinates_cell(cellular_grid CG, int x, int y){
-    return x>=-1 && x<=CG->inner_width+1 && y>=-1 && y<=CG->inner_height+1;
+    return x>=-CG->halo && x<CG->inner_width+CG->halo && y>=-CG->halo && y<CG->inner_height+CG->halo;
 }
 
 bit* get_neighbors(cellular_grid CG, int x, int y){
@@ -17,48 +23,77 @@ bit* get_neighbors(cellular_grid CG, int x, int y){
 }
 
 
-cellular_grid create_cell_grid(uint width, uint height, bit (* convolution) (bit *)){
+cellular_grid create_cell_grid_from(uint width, uint height, uint halo, bit (* convolution) (bit *), bit* values, bit* buffer_values){
     cellular_grid CG = malloc(sizeof(struct _cellular_grid));
-    CG->grid = create_grid(width+2,height+2);
+    if(values==NULL){
+        CG->grid = create_grid(width+2*halo,height+2*halo);
+        CG->buffer = create_grid(width+2*halo,height+2*halo);
+    } else {
+        CG->grid = create_grid_from(width+2*halo,height+2*halo,values);
+        CG->buffer = create_grid_from(width+2*halo,height+2*halo,buffer_values);
+    }
     CG->convolution = convolution;
-    CG->width = width + 2;
-    CG->height = height + 2;    
+    CG->width = width + 2*halo;
+    CG->height = height + 2*halo;    
     CG->inner_width = width;
     CG->inner_height = height;
+    CG->halo = halo;
+    CG->walls = NULL;
 
     return CG;
 }
 
+cellular_grid create_cell_grid(uint width, uint height, uint halo, bit (* convolution) (bit *)){
+    return create_cell_grid_from(width,height,halo,convolution,NULL,NULL);
+}
+
 void delete_cell_grid(cellular_grid CG){
     delete_grid(CG->grid);
+    delete_grid(CG->buffer);
+    free(CG->walls);
     free(CG);
 }
 
 
 int get_cell(cellular_grid CG, int x, int y){
     if (!valid_coordinates_cell(CG,x,y)) return -1;
-    return get_bit(CG->grid,x+1,y+1)?1:0;
+    return get_bit(CG->grid,x+CG->halo,y+CG->halo)?1:0;
 }
 
 int set_cell(cellular_grid CG, int x, int y, int new_value){
     if (!valid_coordinates_cell(CG,x,y)) return -1;
-    return set_bit(CG->grid,x+1,y+1,new_value>0);
+    return set_bit(CG->grid,x+CG->halo,y+CG->halo,new_value>0);
+}
+
+int count_cells(cellular_grid CG, int x, int y, int width, int height){
+    int x_end = (x+width > CG->inner_width)? CG->inner_width : x+width;
+    int y_end = (y+height > CG->inner_height)? CG->inner_height : y+height;
+    if(x<0) x = 0;
+    if(y<0) y = 0;
+
+    int count = 0;
+    for(int j=y; j<y_end; j++){
+        bit* row = CG->grid->value + (size_t)(j+CG->halo)*CG->width + CG->halo;
+        for(int i=x; i<x_end; i++) count += row[i];
+    }
+    return count;
 }
 
 void get_wall(cellular_grid CG, enum side s, int* values){
+    int k = CG->halo;
     switch (s){
     case North:
-        for(int x=-1; x<=CG->inner_width; x++) values[x+1] = get_cell(CG,x,0);
+        for(int l=0; l<k; l++) for(int x=-k; x<CG->inner_width+k; x++) values[l*CG->width+x+k] = get_cell(CG,x,l);
         break;
     case South:
-        for(int x=-1; x<=CG->inner_width; x++) values[x+1] = get_cell(CG,x,CG->inner_height-1);
+        for(int l=0; l<k; l++) for(int x=-k; x<CG->inner_width+k; x++) values[l*CG->width+x+k] = get_cell(CG,x,CG->inner_height-k+l);
         break;
     
     case West:
-        for(int y=-1; y<=CG->inner_height; y++) values[y+1] = get_cell(CG,0,y);
+        for(int l=0; l<k; l++) for(int y=-k; y<CG->inner_height+k; y++) values[l*CG->height+y+k] = get_cell(CG,l,y);
         break;
     case East:
-        for(int y=-1; y<=CG->inner_height; y++) values[y+1] = get_cell(CG,CG->inner_width-1,y);
+        for(int l=0; l<k; l++) for(int y=-k; y<CG->inner_height+k; y++) values[l*CG->height+y+k] = get_cell(CG,CG->inner_width-k+l,y);
         break;
 
     default:
@@ -67,19 +102,52 @@ void get_wall(cellular_grid CG, enum side s, int* values){
 }
 
 int set_wall(cellular_grid CG, enum side s, int* values){
+    int k = CG->halo;
     switch (s){
     case North:
-        for(int x=-1; x<=CG->inner_width; x++) set_cell(CG,x,-1,values[x+1]);
+        for(int l=0; l<k; l++) for(int x=-k; x<CG->inner_width+k; x++) set_cell(CG,x,-k+l,values[l*CG->width+x+k]);
         break;
     case South:
-        for(int x=-1; x<=CG->inner_width; x++) set_cell(CG,x,CG->inner_height,values[x+1]);
+        for(int l=0; l<k; l++) for(int x=-k; x<CG->inner_width+k; x++) set_cell(CG,x,CG->inner_height+l,values[l*CG->width+x+k]);
         break;
     
     case West:
-        for(int y=-1; y<=CG->inner_height; y++) set_cell(CG,-1,y,values[y+1]?1:0);
+        for(int l=0; l<k; l++) for(int y=-k; y<CG->inner_height+k; y++) set_cell(CG,-k+l,y,values[l*CG->height+y+k]?1:0);
         break;
     case East:
-        for(int y=-1; y<=CG->inner_height; y++) set_cell(CG,CG->inner_width,y,values[y+1]);
+        for(int l=0; l<k; l++) for(int y=-k; y<CG->inner_height+k; y++) set_cell(CG,CG->inner_width+l,y,values[l*CG->height+y+k]);
+        break;
+
+    default:
+        return -1;
+        break;
+    }
+    return 1;
+}
+
+int copy_wall(cellular_grid CG, enum side s, grid neighbor){
+    size_t k = CG->halo;
+    size_t width = CG->width;
+    size_t height = CG->height;
+    bit* values = CG->grid->value;
+
+    switch (s){
+    case North:
+        if(neighbor->width!=width) return -1;
+        memcpy(values, neighbor->value + (neighbor->height-2*k)*width, k*width*sizeof(bit));
+        break;
+    case South:
+        if(neighbor->width!=width) return -1;
+        memcpy(values + (height-k)*width, neighbor->value + k*width, k*width*sizeof(bit));
+        break;
+
+    case West:
+        if(neighbor->height!=height) return -1;
+        for(size_t y=0; y<height; y++) memcpy(values + y*width, neighbor->value + y*neighbor->width + neighbor->width-2*k, k*sizeof(bit));
+        break;
+    case East:
+        if(neighbor->height!=height) return -1;
+        for(size_t y=0; y<height; y++) memcpy(values + y*width + width-k, neighbor->value + y*neighbor->width + k, k*sizeof(bit));
         break;
 
     default:
@@ -90,18 +158,229 @@ int set_wall(cellular_grid CG, enum side s, int* values){
 }
 
 void next_generation(cellular_grid CG){
-    grid new_generation = copy(CG->grid);
+    // The back buffer is used instead of a new grid, so the grid stays where it was allocated (e.g. shared memory)
+    grid new_generation = CG->buffer;
+    memcpy(new_generation->value,CG->grid->value,CG->grid->size*sizeof(bit));
     for(int y=0; y<CG->inner_height; y++){
         for(int x=0; x<CG->inner_width; x++){
             bit* n = get_neighbors(CG,x,y);
-            set_bit(new_generation,x+1,y+1,CG->convolution(n));
+            set_bit(new_generation,x+CG->halo,y+CG->halo,CG->convolution(n));
             free(n);
         }
     }
-    delete_grid(CG->grid);
+    CG->buffer = CG->grid;
     CG->grid = new_generation;
 }
 
+extraction create_extraction(int offset_x, int offset_y){
+    extraction E = calloc(1,sizeof(struct _extraction));
+    E->offset_x = offset_x;
+    E->offset_y = offset_y;
+    return E;
+}
+
+void delete_extraction(extraction E){
+    for(int i=0; i<E->nb_threads; i++) free(E->threads[i].points);
+    free(E->threads);
+    free(E->points);
+    free(E);
+}
+
+/**
+ * @brief Resizes an extraction buffer, stopping the program with a message if it can't
+ * (a crash on a NULL buffer would be much harder to understand with billions of points).
+ * 
+ * @param buffer The buffer to resize (NULL to allocate it)
+ * @param count Number of elements
+ * @param size Size of an element
+ * @return void* The resized buffer
+ */
+void* resize_extraction_buffer(void* buffer, size_t count, size_t size){
+    void* resized = (count<=SIZE_MAX/size)? realloc(buffer,count*size) : NULL;
+    if(resized==NULL){
+        fprintf(stderr,"Can't allocate an extraction buffer of %zu elements of %zu bytes.\n",count,size);
+        abort();
+    }
+    return resized;
+}
+
+/**
+ * @brief Gets a buffer for each thread that may extract points, and empties them.
+ * 
+ * @param E The extraction buffers
+ */
+void prepare_extraction(extraction E){
+    #ifdef _OPENMP
+    int nb_threads = omp_get_max_threads();
+    #else
+    int nb_threads = 1;
+    #endif
+    if(E->nb_threads<nb_threads){
+        E->threads = resize_extraction_buffer(E->threads,nb_threads,sizeof(struct _extraction_buffer));
+        memset(E->threads+E->nb_threads,0,(nb_threads-E->nb_threads)*sizeof(struct _extraction_buffer));
+        E->nb_threads = nb_threads;
+    }
+    for(int i=0; i<E->nb_threads; i++) E->threads[i].nb_points = 0;
+}
+
+/**
+ * @brief Concatenates the points extracted by each thread.
+ * 
+ * @param E The extraction buffers
+ */
+void merge_extraction(extraction E){
+    size_t nb_points = 0;
+    for(int i=0; i<E->nb_threads; i++) nb_points += E->threads[i].nb_points;
+    if(nb_points>E->capacity){
+        E->capacity = nb_points;
+        E->points = resize_extraction_buffer(E->points,E->capacity,sizeof(cell_point));
+    }
+
+    E->nb_points = 0;
+    for(int i=0; i<E->nb_threads; i++){
+        memcpy(E->points+E->nb_points,E->threads[i].points,E->threads[i].nb_points*sizeof(cell_point));
+        E->nb_points += E->threads[i].nb_points;
+    }
+}
+
+void push_point(struct _extraction_buffer* buffer, int x, int y){
+    if(buffer->nb_points==buffer->capacity){
+        buffer->capacity = (buffer->capacity>0)? 2*buffer->capacity : 1024;
+        buffer->points = resize_extraction_buffer(buffer->points,buffer->capacity,sizeof(cell_point));
+    }
+    buffer->points[buffer->nb_points].x = x;
+    buffer->points[buffer->nb_points].y = y;
+    buffer->nb_points++;
+}
+
+/**
+ * @brief Extracts the alive cells of a part of a row of the inner grid.
+ * 
+ * @param E The extraction buffers
+ * @param buffer Buffer of the calling thread
+ * @param x Position x of the part of the row (inner coordinates)
+ * @param y Position y of the row (inner coordinates)
+ * @param values Values of the cells in the last generation
+ * @param length Number of cells
+ */
+void extract_row(extraction E, struct _extraction_buffer* buffer, int x, int y, bit* values, int length){
+    for(int i=0; i<length; i++) if(values[i]) push_point(buffer,E->offset_x+x+i,E->offset_y+y);
+}
+
+void extract_cells(cellular_grid CG, extraction E){
+    prepare_extraction(E);
+    for(int y=0; y<CG->inner_height; y++){
+        size_t row = (size_t)(y+CG->halo)*CG->width + CG->halo;
+        extract_row(E,&E->threads[0],0,y,CG->grid->value+row,CG->inner_width);
+    }
+    merge_extraction(E);
+}
+
+/**
+ * @brief Advances one tile of 'steps' generations. The tile is loaded with a margin of 'steps' cells,
+ * and each generation shrinks the valid area by 1 cell, so only the tile itself is valid at the end.
+ * 
+ * @param CG The referenced Cellular Grid
+ * @param tx Position x of the tile (inner coordinates)
+ * @param ty Position y of the tile (inner coordinates)
+ * @param tw Width of the tile
+ * @param th Height of the tile
+ * @param steps Number of generations to compute
+ * @param current Scratch buffer of at least (tw+2*steps)*(th+2*steps) cells
+ * @param next Scratch buffer of the same size
+ * @param E The extraction buffers (NULL for no extraction)
+ * @param buffer Extraction buffer of the calling thread
+ */
+void step_tile(cellular_grid CG, int tx, int ty, int tw, int th, int steps, bit* current, bit* next, extraction E, struct _extraction_buffer* buffer){
+    int w = tw + 2*steps;
+    int h = th + 2*steps;
+    int k = CG->halo;
+
+    // Loading the tile and its margin
+    for(int j=0; j<h; j++)
+        memcpy(current + j*w, CG->grid->value + (size_t)(ty-steps+j+k)*CG->width + tx-steps+k, w*sizeof(bit));
+
+    // Generations are computed in the scratch buffers, on an area shrinking by 1 cell at each step
+    bit neighbors[9];
+    for(int s=1; s<=steps; s++){
+        for(int j=s; j<h-s; j++){
+            for(int i=s; i<w-s; i++){
+                for(int dy=0; dy<3; dy++)
+                    for(int dx=0; dx<3; dx++)
+                        neighbors[dy*3+dx] = current[(j-1+dy)*w + i-1+dx];
+                next[j*w+i] = CG->convolution(neighbors);
+            }
+        }
+        bit* swap = current;
+        current = next;
+        next = swap;
+    }
+
+    // Writing back the tile itself, extracting it while it is still in cache
+    for(int j=0; j<th; j++){
+        memcpy(CG->buffer->value + (size_t)(ty+j+k)*CG->width + tx+k, current + (j+steps)*w + steps, tw*sizeof(bit));
+        if(E!=NULL) extract_row(E,buffer,tx,ty+j,current + (j+steps)*w + steps,tw);
+    }
+}
+
+int next_generations(cellular_grid CG, int steps, int tile_width, int tile_height, extraction E){
+    if(steps<1 || steps>CG->halo) return -1;
+    if(E!=NULL) prepare_extraction(E);
+    if(tile_width<1 || tile_width>CG->inner_width) tile_width = CG->inner_width;
+    if(tile_height<1 || tile_height>CG->inner_height) tile_height = CG->inner_height;
+
+    int nb_tiles_x = (CG->inner_width + tile_width - 1) / tile_width;
+    int nb_tiles = nb_tiles_x * ((CG->inner_height + tile_height - 1) / tile_height);
+    size_t scratch_size = (size_t)(tile_width+2*steps)*(tile_height+2*steps);
+
+    // Tiles are split between threads in row-major order, like the rows first touched in create_grid
+    #ifdef _OPENMP
+    #pragma omp parallel
+    #endif
+    {
+        bit* current = malloc(scratch_size*sizeof(bit));
+        bit* next = malloc(scratch_size*sizeof(bit));
+
+        #ifdef _OPENMP
+        struct _extraction_buffer* buffer = (E!=NULL)? &E->threads[omp_get_thread_num()] : NULL;
+        #else
+        struct _extraction_buffer* buffer = (E!=NULL)? &E->threads[0] : NULL;
+        #endif
+
+        #ifdef _OPENMP
+        #pragma omp for schedule(static)
+        #endif
+        for(int t=0; t<nb_tiles; t++){
+            int tx = (t%nb_tiles_x)*tile_width;
+            int ty = (t/nb_tiles_x)*tile_height;
+            int tw = (tx+tile_width > CG->inner_width)? CG->inner_width-tx : tile_width;
+            int th = (ty+tile_height > CG->inner_height)? CG->inner_height-ty : tile_height;
+            step_tile(CG,tx,ty,tw,th,steps,current,next,E,buffer);
+        }
+        free(current);
+        free(next);
+    }
+    if(E!=NULL) merge_extraction(E);
+
+    // The walls are kept as they were, like next_generation does
+    int k = CG->halo;
+    for(int y=0; y<CG->height; y++){
+        bit* from = CG->grid->value + (size_t)y*CG->width;
+        bit* to = CG->buffer->value + (size_t)y*CG->width;
+        if(y<k || y>=CG->height-k){
+            memcpy(to,from,CG->width*sizeof(bit));
+        } else {
+            memcpy(to,from,k*sizeof(bit));
+            memcpy(to+CG->width-k,from+CG->width-k,k*sizeof(bit));
+        }
+    }
+
+    grid swap = CG->grid;
+    CG->grid = CG->buffer;
+    CG->buffer = swap;
+    return 1;
+}
+
 void print_cell_grid(cellular_grid CG){
     printf("\e[1;1H\e[2J");
     for(int y=0; y<CG->inner_height; y++){
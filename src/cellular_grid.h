@@ -6,11 +6,14 @@ enum side{North,East,South,West};
 
 struct _cellular_grid{
     grid grid;
+    grid buffer;        // Back buffer written by next_generations, then swapped with grid
     bit (* convolution) (bit *);
     int width;
     int height;    
     int inner_width;
     int inner_height;
+    int halo;           // Depth of the 'virtual walls' around the inner grid
+    int* walls;         // Int arrays used to send and receive the walls through messages (allocated on first use)
 };
 
 struct _cell_point{
@@ -19,14 +22,44 @@ struct _cell_point{
     int y;
 };
 
+struct _extraction_buffer{
+    struct _cell_point* points;
+    size_t nb_points;
+    size_t capacity;
+};
+
+struct _extraction{
+    int offset_x;                           // Added to the x of the points (position of the inner grid in the whole grid)
+    int offset_y;                           // Added to the y of the points
+    struct _cell_point* points;             // Alive cells of the last generation computed
+    size_t nb_points;
+    size_t capacity;
+    struct _extraction_buffer* threads;     // Points extracted by each thread, merged at the end of the generation
+    int nb_threads;
+};
+
 
 typedef struct _cellular_grid * cellular_grid;
 typedef struct _cell_point cell_point;
+typedef struct _extraction * extraction;
 
-cellular_grid create_cell_grid(uint width, uint height, bit (* convolution) (bit *));
+cellular_grid create_cell_grid(uint width, uint height, uint halo, bit (* convolution) (bit *));
 
 void delete_cell_grid(cellular_grid CG);
 
+/**
+ * @brief Create a cellular grid whose grid and back buffer are in already allocated arrays (e.g. shared memory).
+ * 
+ * @param width Width of the inner grid
+ * @param height Height of the inner grid
+ * @param halo Depth of the walls
+ * @param convolution The convolution function
+ * @param values Array of at least (width+2*halo)*(height+2*halo) bits for the grid (NULL to allocate them like create_cell_grid)
+ * @param buffer_values Array of the same size for the back buffer
+ * @return cellular_grid The created Cellular Grid
+ */
+cellular_grid create_cell_grid_from(uint width, uint height, uint halo, bit (* convolution) (bit *), bit* values, bit* buffer_values);
+
 int get_cell(cellular_grid CG, int x, int y);
 
 int set_cell(cellular_grid CG, int x, int y, int new_value);
@@ -35,6 +68,64 @@ void get_wall(cellular_grid CG, enum side s, int* values);
 
 int set_wall(cellular_grid CG, enum side s, int* values);
 
+/**
+ * @brief Fills a wall directly from the opposite border of a neighbor's grid (e.g. in shared memory), without going through an int array.
+ * 
+ * @param CG The referenced Cellular Grid
+ * @param s The wall to fill
+ * @param neighbor The grid of the neighbor on side s, with the same halo depth
+ * @return int Status = 1 for no error | -1 incompatible grid or invalid side
+ */
+int copy_wall(cellular_grid CG, enum side s, grid neighbor);
+
+/**
+ * @brief Counts the alive cells of a rectangle of the inner grid (clipped to the inner grid).
+ * 
+ * @param CG The referenced Cellular Grid
+ * @param x Position x of the rectangle
+ * @param y Position y of the rectangle
+ * @param width Width of the rectangle
+ * @param height Height of the rectangle
+ * @return int Number of alive cells
+ */
+int count_cells(cellular_grid CG, int x, int y, int width, int height);
+
 void next_generation(cellular_grid CG);
 
+/**
+ * @brief Creates the buffers receiving the alive cells extracted by the stepper, reused from one generation to the next.
+ * 
+ * @param offset_x Added to the x of the points (position of the inner grid in the whole grid)
+ * @param offset_y Added to the y of the points
+ * @return extraction The created extraction buffers
+ */
+extraction create_extraction(int offset_x, int offset_y);
+
+void delete_extraction(extraction E);
+
+/**
+ * @brief Extracts the alive cells of the current generation in a separate pass over the grid.
+ * Used when the stepper can't do it itself.
+ * 
+ * @param CG The referenced Cellular Grid
+ * @param E The extraction buffers
+ */
+void extract_cells(cellular_grid CG, extraction E);
+
+/**
+ * @brief Computes several generations at once, one cache-sized tile at a time (overlapped temporal tiling).
+ * Each tile is loaded with a margin of 'steps' cells and advanced 'steps' generations before being written back,
+ * so the whole grid is only streamed through memory once. Gives the same result as 'steps' calls to next_generation
+ * as long as the walls were filled at depth 'steps' beforehand.
+ * The last generation can also be extracted while each tile is written back, instead of in another pass over the grid.
+ * 
+ * @param CG The referenced Cellular Grid
+ * @param steps Number of generations to compute (between 1 and CG->halo)
+ * @param tile_width Width of the tiles
+ * @param tile_height Height of the tiles
+ * @param E The extraction buffers (NULL for no extraction)
+ * @return int Status = 1 for no error | -1 invalid number of steps
+ */
+int next_generations(cellular_grid CG, int steps, int tile_width, int tile_height, extraction E);
+
 void print_cell_grid(cellular_grid CG);
\ No newline at end of file
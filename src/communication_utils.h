@@ -7,3 +7,12 @@ struct comm_schema {
     int y;
     int master;
 };
+
+
+struct viewport {
+    int x;
+    int y;
+    int width;
+    int height;
+    int zoom;
+};
\ No newline at end of file
@@ -1,31 +1,77 @@
 #include <stdlib.h>
+#include <string.h>
 #include "grid.h"
 
+#ifdef HUGE_PAGES
+#include <stdint.h>
+#include <sys/mman.h>
+#endif
 
-_Bool valid_coordinates(grid G, uint x, uint y){
+
+_Bool valid_coordinates(grid G, size_t x, size_t y){
     return x<G -> width && y<G -> height;
 }
 
-grid create_grid(uint width, uint height){
+bit* allocate_values(size_t size){
+    #ifdef HUGE_PAGES
+    // Aligned and rounded up to whole huge pages, so the kernel can back all of it with transparent huge pages
+    size_t rounded_size = (size*sizeof(bit) + VALUES_ALIGNMENT - 1) / VALUES_ALIGNMENT * VALUES_ALIGNMENT;
+    void* values = NULL;
+    if(posix_memalign(&values,VALUES_ALIGNMENT,rounded_size)!=0) return NULL;
+    madvise(values,rounded_size,MADV_HUGEPAGE);
+    return (bit *) values;
+    #else
+    return (bit *) malloc(size*sizeof(bit));
+    #endif
+}
+
+size_t align_values(bit* memory, size_t size){
+    #ifdef HUGE_PAGES
+    size_t offset = (VALUES_ALIGNMENT - (uintptr_t)memory % VALUES_ALIGNMENT) % VALUES_ALIGNMENT;
+    // Only whole huge pages are advised, the end of the values stays in regular pages
+    size_t huge_size = size*sizeof(bit) / VALUES_ALIGNMENT * VALUES_ALIGNMENT;
+    if(huge_size>0) madvise(memory+offset,huge_size,MADV_HUGEPAGE);
+    return offset;
+    #else
+    return 0;
+    #endif
+}
+
+grid create_grid_from(size_t width, size_t height, bit* values){
     grid G = malloc(sizeof(struct _grid));
     G -> width = width;
     G -> height = height;
     G -> size = width*height;
-    G -> value = (bit *) malloc(height*width*sizeof(bit));
+    G -> value = values;
+    G -> owner = 0;
+
+    // First touch : rows are split between threads like the tiles of next_generations, so pages are placed on their NUMA node
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+    #endif
+    for(size_t y=0; y<height; y++){
+        memset(G->value + y*width, 0, width*sizeof(bit));
+    }
+    return G;
+}
+
+grid create_grid(size_t width, size_t height){
+    grid G = create_grid_from(width,height,allocate_values(width*height));
+    G -> owner = 1;
     return G;
 }
 
 void delete_grid(grid G){
-    free(G->value);
+    if(G->owner) free(G->value);
     free(G);
 }
 
-int get_bit(grid G, uint x, uint y){
+int get_bit(grid G, size_t x, size_t y){
     if (!valid_coordinates(G,x,y)) return -1;
     return G -> value[y*G->width + x];
 }
 
-int set_bit(grid G, uint x, uint y, bit new_bit){
+int set_bit(grid G, size_t x, size_t y, bit new_bit){
     if (!valid_coordinates(G,x,y)) return -1;
     G -> value[y*G->width + x] = new_bit;
     return 1;
@@ -33,7 +79,7 @@ int set_bit(grid G, uint x, uint y, bit new_bit){
 
 int set_bits(grid G, bit * new_values){
     if(sizeof(new_values)<G -> size) return -1;
-    for(uint i=0; i<G -> size; i++){
+    for(size_t i=0; i<G -> size; i++){
         G->value[i] = new_values[i];
     }
     return 1;
@@ -52,8 +98,6 @@ int set_bits_points(grid G, point * p, uint nb_points){
 
 grid copy(grid G){
     grid g = create_grid(G->width,G->height);
-    for(uint i=0; i<G -> size; i++){
-        g->value[i] = G->value[i];
-    }
+    memcpy(g->value,G->value,G->size*sizeof(bit));
     return g;
 }
\ No newline at end of file
@@ -2,11 +2,18 @@
 
 #define bit _Bool
 
+#ifdef HUGE_PAGES
+#define VALUES_ALIGNMENT (2*1024*1024)  // Size of a huge page, alignment of the value arrays
+#else
+#define VALUES_ALIGNMENT 1
+#endif
+
 struct _grid{
     bit * value;    // Array containing the bit values of the grid
-    uint width;     // Width of the grid
-    uint height;    // Height of the grid
-    uint size;      // Size of the value array = width*height
+    size_t width;   // Width of the grid
+    size_t height;  // Height of the grid
+    size_t size;    // Size of the value array = width*height
+    bit owner;      // Whether the value array is freed along with the grid
 };
 
 struct _point{
@@ -19,13 +26,36 @@ typedef struct _grid* grid;
 typedef struct _point* point;
 
 /**
- * @brief Create a grid structure.
+ * @brief Create a grid structure, with all bits at 0.
+ * The rows are first touched by the threads that will later step them (see next_generations),
+ * and the values are backed by 2MB huge pages when compiled with HUGE_PAGES.
+ * 
+ * @param width Grid's width
+ * @param height Grid's height
+ * @return grid The created grid
+ */
+grid create_grid(size_t width, size_t height);
+
+/**
+ * @brief Prepares memory allocated elsewhere (e.g. shared memory) to hold values : with HUGE_PAGES, the values must start
+ * at a huge page boundary, and the kernel is advised to back them with huge pages.
+ * 
+ * @param memory The allocated memory, of at least size + VALUES_ALIGNMENT - 1 bits
+ * @param size Number of values it will hold
+ * @return size_t Offset in the memory where the values must start
+ */
+size_t align_values(bit* memory, size_t size);
+
+/**
+ * @brief Create a grid structure over an already allocated array (e.g. shared memory), with all bits at 0.
+ * The array is not freed by delete_grid.
  * 
  * @param width Grid's width
  * @param height Grid's height
+ * @param values Array of at least width*height bits
  * @return grid The created grid
  */
-grid create_grid(uint width, uint height);
+grid create_grid_from(size_t width, size_t height, bit* values);
 
 /**
  * @brief Deletes grid structure.
@@ -42,7 +72,7 @@ void delete_grid(grid G);
  * @param y Position y of the point to get
  * @return int The value read (0 or 1, -1 if invalid position)
  */
-int get_bit(grid G, uint x, uint y);
+int get_bit(grid G, size_t x, size_t y);
 
 /**
  * @brief Set the value of a bit at a given position of a grid.
@@ -53,7 +83,7 @@ int get_bit(grid G, uint x, uint y);
  * @param new_bit 
  * @return int Status = 1 for no error | -1 invalid position
  */
-int set_bit(grid G, uint x, uint y, bit new_bit);
+int set_bit(grid G, size_t x, size_t y, bit new_bit);
 
 /**
  * @brief Set values of a grid from a set of values.
@@ -36,9 +36,24 @@ void create_render(char* path_to_svg_folder, int width, int height){
 void render_generation(cell_point* points, int nb_points, int generation){
     for(int i=0; i<nb_points; i++){
         if(generation == 0)
-            fprintf(svg,"<rect width='0' height='1' x='%d' y='%d' fill='black'><animate id='gen%d' attributeName='width' values='1' begin='0s;gen%d.end' dur='%s'/></rect>\n",points[i].x,points[i].y,generation,ITERATIONS-1,SVG_GEN_DURATION);
+            fprintf(svg,"<rect width='0' height='1' x='%d' y='%d' fill='black'><animate id='gen%d' attributeName='width' values='1' begin='0s;gen%d.end' dur='%s'/></rect>\n",points[i].x,points[i].y,generation,(ITERATIONS-1)/HALO_DEPTH*HALO_DEPTH,SVG_GEN_DURATION);
         else
-            fprintf(svg,"<rect width='0' height='1' x='%d' y='%d' fill='black'><animate id='gen%d' attributeName='width' values='1' begin='gen%d.end' dur='%s'/></rect>\n",points[i].x,points[i].y,generation,generation - 1,SVG_GEN_DURATION);
+            fprintf(svg,"<rect width='0' height='1' x='%d' y='%d' fill='black'><animate id='gen%d' attributeName='width' values='1' begin='gen%d.end' dur='%s'/></rect>\n",points[i].x,points[i].y,generation,generation - HALO_DEPTH,SVG_GEN_DURATION);
+    }
+}
+
+void render_frame(int* densities, struct viewport view, int generation){
+    int width = (view.width + view.zoom - 1)/view.zoom;
+    int height = (view.height + view.zoom - 1)/view.zoom;
+    int previous = (generation == 0)? (ITERATIONS-1)/HALO_DEPTH*HALO_DEPTH : generation - HALO_DEPTH;
+    for(int y=0; y<height; y++){
+        for(int x=0; x<width; x++){
+            int density = densities[y*width + x];
+            if(density == 0) continue;
+            // The pixel's opacity is the proportion of alive cells it shows (pixels on the right and bottom may show less cells)
+            int area = ((view.width - x*view.zoom < view.zoom)? view.width - x*view.zoom : view.zoom) * ((view.height - y*view.zoom < view.zoom)? view.height - y*view.zoom : view.zoom);
+            fprintf(svg,"<rect width='0' height='1' x='%d' y='%d' fill='black' fill-opacity='%.2f'><animate id='gen%d' attributeName='width' values='1' begin='%sgen%d.end' dur='%s'/></rect>\n",x,y,(double)density/area,generation,(generation == 0)?"0s;":"",previous,SVG_GEN_DURATION);
+        }
     }
 }
 
@@ -106,6 +121,22 @@ void render_generation(cell_point* points, int nb_points, int dull){
     usleep(DISPLAY_TIME_INTERVAL_U);
 }
 
+void render_frame(int* densities, struct viewport view, int dull){
+    int width = (view.width + view.zoom - 1)/view.zoom;
+    int height = (view.height + view.zoom - 1)/view.zoom;
+    XClearWindow(main_screen -> dpy, main_screen -> w);
+    for(int y=0; y<height; y++){
+        for(int x=0; x<width; x++){
+            if(densities[y*width + x] > 0)
+                XDrawPoint(main_screen -> dpy, main_screen -> w, main_screen -> gc, x, y);
+        }
+    }
+    XFlush(main_screen -> dpy);
+
+    // Time skip
+    usleep(DISPLAY_TIME_INTERVAL_U);
+}
+
 void finish_render(){
     XDestroyWindow(main_screen -> dpy, main_screen -> w);
     free(main_screen);
@@ -121,6 +152,8 @@ void create_render(char* path_to_svg_folder, int width, int height){}
 
 void render_generation(cell_point* points, int nb_points, int generation){}
 
+void render_frame(int* densities, struct viewport view, int generation){}
+
 void finish_render(){}
 
 #endif
\ No newline at end of file
@@ -1,4 +1,5 @@
 
 void create_render(char* path_to_svg_folder, int width, int height);
 void render_generation(cell_point* points, int nb_points, int generation);
+void render_frame(int* densities, struct viewport view, int generation);
 void finish_render();
\ No newline at end of file
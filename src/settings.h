@@ -3,4 +3,19 @@
 #define ITERATIONS 1000                 // Number of generation for the cellular automata
 #define OUTPUT_PATH "./output"          // Output folder path for the SVG generation
 #define SVG_GEN_DURATION "20ms"         // Time in-between generations in the svg file 
-#define DISPLAY_TIME_INTERVAL_U 20000   // Time in-between generations in the x11 display
\ No newline at end of file
+#define DISPLAY_TIME_INTERVAL_U 20000   // Time in-between generations in the x11 display
+#define INITIAL_DENSITY 10              // One cell out of INITIAL_DENSITY is set alive at random at the start
+#define HALO_DEPTH 1                    // Depth of the walls exchanged between processes = generations computed per exchange (only those generations are rendered)
+#define TILE_WIDTH 256                  // Width of the cache-sized tiles advanced by the local stepper
+#define TILE_HEIGHT 128                 // Height of the cache-sized tiles advanced by the local stepper
+#define VIEWPORT 0                      // 1 to gather a downsampled viewport of the grid for rendering, 0 to gather all alive points
+#define VIEWPORT_X 0                    // Position x of the viewport in the grid
+#define VIEWPORT_Y 0                    // Position y of the viewport in the grid
+#define VIEWPORT_WIDTH WIDTH            // Width of the viewport in cells
+#define VIEWPORT_HEIGHT HEIGHT          // Height of the viewport in cells
+#define VIEWPORT_ZOOM 1                 // Zoom level = side of the square of cells shown by one pixel
+#define TUNING_FILE "./tuning.cache"    // File where the configurations found by the auto-tuning are saved
+#define TUNING_GENERATIONS 16           // Number of generations timed for each configuration tried by the auto-tuning
+#define TUNING_SAMPLE_CACHES 4          // The local grids benchmarked by the auto-tuning are scaled down to fill this many times the cache of a process
+#define TUNING_REPEATS 3                // Number of timed runs for each configuration tried by the auto-tuning (the fastest is kept)
+#define TUNING_MARGIN 0.05              // Relative speedup a configuration needs over the best one found so far to replace it
\ No newline at end of file
@@ -0,0 +1,29 @@
+#include <stdio.h>
+#include <string.h>
+#include "tuning.h"
+
+int read_tuning(char* path, char* signature, struct tuning* t){
+    FILE* file = fopen(path,"r");
+    if(file==NULL) return 0;
+
+    // One line per signature : "<signature> <kernel> <tile_width> <tile_height> <halo> <threads> <comm_height>"
+    char key[256];
+    struct tuning read;
+    int found = 0;
+    while(fscanf(file,"%255s %d %d %d %d %d %d",key,&read.kernel,&read.tile_width,&read.tile_height,&read.halo,&read.threads,&read.comm_height)==7){
+        if(strcmp(key,signature)==0){
+            *t = read;
+            found = 1;
+        }
+    }
+    fclose(file);
+    return found;
+}
+
+int write_tuning(char* path, char* signature, struct tuning t){
+    FILE* file = fopen(path,"a");
+    if(file==NULL) return -1;
+    fprintf(file,"%s %d %d %d %d %d %d\n",signature,t.kernel,t.tile_width,t.tile_height,t.halo,t.threads,t.comm_height);
+    fclose(file);
+    return 1;
+}
\ No newline at end of file
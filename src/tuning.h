@@ -0,0 +1,28 @@
+struct tuning {
+    int kernel;         // Local stepper : 0 = next_generation (reference), 1 = next_generations (tiled)
+    int tile_width;     // Width of the tiles of next_generations
+    int tile_height;    // Height of the tiles of next_generations
+    int halo;           // Depth of the walls = generations computed per exchange
+    int threads;        // Threads per process (only used with OpenMP)
+    int comm_height;    // Number of rows of processes (columns = number of processes / rows)
+};
+
+/**
+ * @brief Reads the configuration saved for a problem signature in a tuning file.
+ * 
+ * @param path Path of the tuning file
+ * @param signature Signature of the problem (without spaces)
+ * @param t The configuration read
+ * @return int Status = 1 if found | 0 if the file or the signature doesn't exist
+ */
+int read_tuning(char* path, char* signature, struct tuning* t);
+
+/**
+ * @brief Saves the configuration of a problem signature at the end of a tuning file (last one saved is used).
+ * 
+ * @param path Path of the tuning file
+ * @param signature Signature of the problem (without spaces)
+ * @param t The configuration to save
+ * @return int Status = 1 for no error | -1 if the file can't be opened
+ */
+int write_tuning(char* path, char* signature, struct tuning t);
\ No newline at end of file